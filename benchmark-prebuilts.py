@@ -0,0 +1,500 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Benchmarks the prebuilt tools in linux-x86/bin.
+
+Each case runs one tool on a fixture generated from a fixed seed, so results
+are comparable across prebuilt updates made with update-prebuilts.sh. One JSON
+object is written per case with wall, user and system time, peak RSS and,
+where the case has a payload, throughput.
+
+Setting BENCHMARK_PREBUILTS_TRACE (or passing --trace) to a path also writes
+every tool invocation as a span in Chrome trace JSON, which loads in Perfetto
+and chrome://tracing. A counter records the size of each run's inputs and of
+its output; for avbtool, which modifies its image in place, the output is the
+growth in the image's allocated size.
+
+Linux carries a process's peak RSS across exec, so a tool started directly
+from this script would report at least the script's own footprint. Peak RSS
+is therefore measured in one extra run per case, forked from a small shell
+that hands the tool over to this script to be reaped.
+
+Representative fixtures can be supplied for the tools that need real kernel
+outputs (--modules-dir for depmod, --vmlinux for pahole); those cases are
+skipped otherwise.
+"""
+
+import argparse
+import ctypes
+import hashlib
+import json
+import os
+import random
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+PREBUILTS_DIR = os.path.join(
+    os.path.dirname(os.path.realpath(__file__)), 'linux-x86')
+BIN_DIR = os.path.join(PREBUILTS_DIR, 'bin')
+AVB_KEY = os.path.join(PREBUILTS_DIR, 'share', 'avb', 'testkey_rsa2048.pem')
+
+# avbtool runs fec from PATH, so make the other prebuilts visible.
+ENV = dict(os.environ, PATH=BIN_DIR + os.pathsep + os.environ.get('PATH', ''))
+
+PR_SET_CHILD_SUBREAPER = 36
+
+# Forks "$@" in the background, prints its pid and exits. The job waits for a
+# line on fd 3 so that it cannot finish, and be reaped by the shell, before the
+# shell itself has exited and handed it to us.
+LAUNCHER = ('exec 3<&0; { read _ <&3; exec "$@" 3<&-; } '
+            '</dev/null >/dev/null 2>&1 & echo $!')
+
+MIB = 1024 * 1024
+BLOCK_SIZE = 4096
+SEED = 0x6b657266
+
+# Commands used to measure process startup and dynamic linking cost, with the
+# exit code each is expected to return. img2simg and simg2img print their usage
+# and exit 255 when given no arguments.
+STARTUP_COMMANDS = [
+    (['depmod', '--version'], 0),
+    (['dtc', '--version'], 0),
+    (['lz4', '-V'], 0),
+    (['img2simg'], 255),
+    (['simg2img'], 255),
+]
+
+
+def tool(name):
+    return os.path.join(BIN_DIR, name)
+
+
+def tool_digest(name):
+    with open(tool(name), 'rb') as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+
+class Trace(object):
+    """Collects Chrome trace events, one track per tool."""
+
+    def __init__(self):
+        self.epoch = time.perf_counter()
+        self.events = []
+        self.tids = {}
+
+    def _us(self, seconds):
+        return round((seconds - self.epoch) * 1e6, 3)
+
+    def _tid(self, name):
+        if name not in self.tids:
+            self.tids[name] = len(self.tids) + 1
+            self.events.append({'ph': 'M', 'name': 'thread_name', 'pid': 1,
+                                'tid': self.tids[name],
+                                'args': {'name': name}})
+        return self.tids[name]
+
+    def span(self, name, case, start, wall, args):
+        self.events.append({'ph': 'X', 'name': case, 'cat': name, 'pid': 1,
+                            'tid': self._tid(name), 'ts': self._us(start),
+                            'dur': round(wall * 1e6, 3), 'args': args})
+
+    def counter(self, name, when, values):
+        self.events.append({'ph': 'C', 'name': name, 'pid': 1,
+                            'ts': self._us(when), 'args': values})
+
+    def write(self, path):
+        with open(path, 'w') as f:
+            json.dump({'traceEvents': self.events,
+                       'displayTimeUnit': 'ms'}, f)
+
+
+def disk_usage(path):
+    """Returns the size of a file, or the total size of a directory tree."""
+    if not os.path.isdir(path):
+        return os.path.getsize(path)
+    total = 0
+    for root, _, files in os.walk(path):
+        for name in files:
+            total += os.lstat(os.path.join(root, name)).st_size
+    return total
+
+
+def allocated_size(path):
+    return os.stat(path).st_blocks * 512
+
+
+def run(cmd):
+    """Runs cmd and returns (start, wall seconds, rusage, exit code, stderr).
+
+    The CPU times in rusage cover only this child, unlike
+    resource.RUSAGE_CHILDREN. Its ru_maxrss includes this script's own
+    footprint; use peak_rss() instead.
+    """
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, env=ENV, stdin=subprocess.DEVNULL,
+                            stdout=subprocess.DEVNULL,
+                            stderr=subprocess.PIPE)
+    stderr = proc.stderr.read()
+    proc.stderr.close()
+    _, status, rusage = os.wait4(proc.pid, 0)
+    wall = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    return start, wall, rusage, proc.returncode, stderr
+
+
+def peak_rss(cmd):
+    """Runs cmd from a small launcher and returns its peak RSS in KiB.
+
+    Requires this process to be a child subreaper, see main().
+    """
+    go_read, go_write = os.pipe()
+    launcher = subprocess.Popen(['/bin/sh', '-c', LAUNCHER, 'sh'] + cmd,
+                                env=ENV, stdin=go_read, stdout=subprocess.PIPE)
+    os.close(go_read)
+    pid = int(launcher.communicate()[0])
+    os.write(go_write, b'\n')
+    os.close(go_write)
+    _, _, rusage = os.wait4(pid, 0)
+    return rusage.ru_maxrss
+
+
+class Fixtures(object):
+    """Generates deterministic inputs in a scratch directory."""
+
+    def __init__(self, workdir, size):
+        self.workdir = workdir
+        self.size = size
+
+    def path(self, name):
+        return os.path.join(self.workdir, name)
+
+    @staticmethod
+    def rng(name):
+        """Returns a generator private to one fixture.
+
+        Each fixture gets its own seed so that its contents do not depend on
+        which other fixtures were generated before it.
+        """
+        return random.Random('%d:%s' % (SEED, name))
+
+    def text(self):
+        """Compressible data resembling build logs and symbol tables."""
+        path = self.path('text.bin')
+        if not os.path.exists(path):
+            rng = self.rng('text')
+            words = ['%s_%x' % (w, i) for i, w in enumerate(
+                ['module', 'symbol', 'driver', 'probe', 'init', 'exit',
+                 'device', 'kernel', 'section', 'vendor'] * 64)]
+            with open(path, 'w') as f:
+                written = 0
+                while written < self.size:
+                    line = '%016x %s\n' % (rng.getrandbits(64),
+                                           ' '.join(rng.choices(words, k=6)))
+                    f.write(line)
+                    written += len(line)
+        return path
+
+    def raw_image(self):
+        """A raw image with alternating data, zero and hole regions."""
+        path = self.path('raw.img')
+        if not os.path.exists(path):
+            rng = self.rng('raw_image')
+            chunk = 256 * 1024
+            with open(path, 'wb') as f:
+                for i in range(self.size // chunk):
+                    kind = i % 4
+                    if kind in (0, 1):
+                        f.write(rng.randbytes(chunk))
+                    elif kind == 2:
+                        f.write(bytes(chunk))
+                    else:
+                        f.seek(chunk, os.SEEK_CUR)
+                f.truncate(self.size)
+        return path
+
+    def sparse_image(self):
+        """raw_image() converted with img2simg."""
+        path = self.path('sparse.img')
+        if not os.path.exists(path):
+            subprocess.check_call([tool('img2simg'), self.raw_image(), path,
+                                   str(BLOCK_SIZE)], env=ENV)
+        return path
+
+    def lz4_text(self):
+        """text() compressed with lz4."""
+        path = self.path('text.lz4.in')
+        if not os.path.exists(path):
+            subprocess.check_call([tool('lz4'), '-q', '-f', self.text(), path],
+                                  env=ENV)
+        return path
+
+    def tree(self):
+        """A directory of files of mixed size and compressibility."""
+        path = self.path('tree')
+        if not os.path.exists(path):
+            rng = self.rng('tree')
+            text_size = os.path.getsize(self.text())
+            written = 0
+            index = 0
+            with open(self.text(), 'rb') as text:
+                while written < self.size // 2:
+                    subdir = os.path.join(path, 'd%02d' % (index % 16))
+                    os.makedirs(subdir, exist_ok=True)
+                    length = rng.choice([512, 4096, 65536, 1 * MIB])
+                    if index % 2:
+                        data = rng.randbytes(length)
+                    else:
+                        text.seek(rng.randrange(text_size - length))
+                        data = text.read(length)
+                    with open(os.path.join(subdir, 'f%05d' % index),
+                              'wb') as f:
+                        f.write(data)
+                    written += length
+                    index += 1
+        return path
+
+
+def cases(fixtures, args):
+    """Yields (tool, case, payload bytes, command, inputs, output).
+
+    The output is removed after the case. An output that is also listed in
+    inputs is modified in place by the tool.
+    """
+    work = fixtures.path
+    size = fixtures.size
+    partition_size = size + 16 * MIB
+
+    def wanted(name):
+        return not args.tool or name in args.tool
+
+    if wanted('lz4'):
+        text = fixtures.text()
+        yield ('lz4', 'compress', size,
+               [tool('lz4'), '-q', '-f', text, work('text.lz4')],
+               [text], work('text.lz4'))
+        yield ('lz4', 'compress-hc', size,
+               [tool('lz4'), '-q', '-f', '-9', text, work('text.lz4')],
+               [text], work('text.lz4'))
+        yield ('lz4', 'decompress', size,
+               [tool('lz4'), '-q', '-f', '-d', fixtures.lz4_text(),
+                work('text.out')], [fixtures.lz4_text()], work('text.out'))
+
+    if wanted('img2simg'):
+        yield ('img2simg', 'convert', size,
+               [tool('img2simg'), fixtures.raw_image(), work('out.img'),
+                str(BLOCK_SIZE)], [fixtures.raw_image()], work('out.img'))
+
+    if wanted('simg2img'):
+        yield ('simg2img', 'convert', size,
+               [tool('simg2img'), fixtures.sparse_image(), work('out.img')],
+               [fixtures.sparse_image()], work('out.img'))
+
+    if wanted('lpmake'):
+        yield ('lpmake', 'sparse-super', size,
+               [tool('lpmake'), '--metadata-size', '65536',
+                '--metadata-slots', '2', '--super-name', 'super',
+                '--device', 'super:%d' % (partition_size + MIB),
+                '--group', 'main:%d' % partition_size,
+                '--partition', 'system:readonly:%d:main' % size,
+                '--image', 'system=%s' % fixtures.sparse_image(),
+                '--sparse', '--output', work('out.img')],
+               [fixtures.sparse_image()], work('out.img'))
+
+    if wanted('mkfs.erofs'):
+        tree = fixtures.tree()
+        yield ('mkfs.erofs', 'uncompressed', size // 2,
+               [tool('mkfs.erofs'), '--quiet', '-T0', '--all-root',
+                work('out.img'), tree], [tree], work('out.img'))
+        yield ('mkfs.erofs', 'lz4hc', size // 2,
+               [tool('mkfs.erofs'), '--quiet', '-T0', '--all-root',
+                '-zlz4hc', work('out.img'), tree], [tree], work('out.img'))
+
+    if wanted('avbtool'):
+        # avbtool replaces an existing footer, so repeated runs on the same
+        # copy do the same amount of work.
+        for footer in ('hash', 'hashtree'):
+            shutil.copyfile(fixtures.raw_image(), work('out.img'))
+            yield ('avbtool', 'add_%s_footer' % footer, size,
+                   [tool('avbtool'), 'add_%s_footer' % footer,
+                    '--image', work('out.img'),
+                    '--partition_size', str(partition_size),
+                    '--partition_name', 'system',
+                    '--algorithm', 'SHA256_RSA2048',
+                    '--key', AVB_KEY], [work('out.img')], work('out.img'))
+
+    if wanted('depmod') and args.modules_dir:
+        # depmod writes its index files next to the modules, so run it on a
+        # copy rather than on the caller's directory.
+        shutil.copytree(args.modules_dir, work('modules'), symlinks=True)
+        yield ('depmod', 'modules', None,
+               [tool('depmod'), '-b', work('modules'), args.kernel_release],
+               [work('modules')], None)
+
+    if wanted('pahole') and args.vmlinux:
+        # Encoding into the ELF itself would modify the input and shell out to
+        # the host's llvm-objcopy, so write the BTF to a separate file.
+        yield ('pahole', 'encode-btf', os.path.getsize(args.vmlinux),
+               [tool('pahole'), '-J',
+                '--btf_encode_detached=%s' % work('vmlinux.btf'),
+                args.vmlinux], [args.vmlinux], work('vmlinux.btf'))
+
+
+def measure(name, case, payload, cmd, inputs, output, repeat, trace):
+    """Runs cmd repeat times and returns the record of the median run."""
+    runs = []
+    input_bytes = sum(disk_usage(path) for path in inputs)
+    # Only avbtool modifies its input in place. It strips the footer an earlier
+    # run added before appending a new one, so every run is compared with the
+    # original image.
+    in_place = output in inputs
+    if in_place:
+        output_base = allocated_size(output)
+    for _ in range(repeat):
+        start, wall, rusage, returncode, stderr = run(cmd)
+        if returncode != 0:
+            sys.stderr.write(stderr.decode(errors='replace'))
+            raise RuntimeError('%s %s failed with exit code %d' %
+                               (name, case, returncode))
+        runs.append((wall, rusage))
+        if trace:
+            output_bytes = 0
+            if in_place:
+                output_bytes = max(0, allocated_size(output) - output_base)
+            elif output and os.path.exists(output):
+                output_bytes = disk_usage(output)
+            trace.span(name, case, start, wall,
+                       {'user_s': rusage.ru_utime, 'sys_s': rusage.ru_stime})
+            trace.counter('bytes', start, {'input': input_bytes,
+                                           'output': output_bytes})
+            trace.counter('bytes', start + wall, {'input': 0, 'output': 0})
+    runs.sort(key=lambda r: r[0])
+    wall, rusage = runs[len(runs) // 2]
+    record = {
+        'tool': name,
+        'case': case,
+        'tool_sha256': tool_digest(name),
+        'runs': repeat,
+        'wall_s': round(wall, 6),
+        'user_s': round(rusage.ru_utime, 6),
+        'sys_s': round(rusage.ru_stime, 6),
+        'max_rss_kib': peak_rss(cmd),
+    }
+    if payload:
+        record['bytes'] = payload
+        record['mib_per_s'] = round(payload / MIB / wall, 2)
+    return record
+
+
+def measure_startup(cmd, expected_returncode, iterations, trace):
+    """Returns the mean latency of starting cmd[0] and waiting for it."""
+    name = cmd[0]
+    argv = [tool(name)] + cmd[1:]
+    walls = []
+    for _ in range(iterations):
+        start, wall, _, returncode, stderr = run(argv)
+        if returncode != expected_returncode:
+            sys.stderr.write(stderr.decode(errors='replace'))
+            raise RuntimeError('%s startup failed with exit code %d' %
+                               (name, returncode))
+        walls.append(wall)
+        if trace:
+            trace.span(name, 'startup', start, wall, {})
+    return {
+        'tool': name,
+        'case': 'startup',
+        'tool_sha256': tool_digest(name),
+        'runs': iterations,
+        'wall_s': round(statistics.mean(walls), 6),
+        'wall_stdev_s': round(statistics.pstdev(walls), 6),
+        'max_rss_kib': peak_rss(argv),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--size-mib', type=int, default=64,
+                        help='size of the synthetic payloads (default: 64)')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='runs per case; the median is reported')
+    parser.add_argument('--startup-iterations', type=int, default=100,
+                        help='invocations per tool for startup latency')
+    parser.add_argument('--modules-dir',
+                        help='base directory to run depmod -b on, i.e. the '
+                        'directory that contains lib/modules/<release>')
+    parser.add_argument('--kernel-release',
+                        help='kernel release to pass to depmod (default: the '
+                        'only entry under <modules-dir>/lib/modules)')
+    parser.add_argument('--vmlinux', help='vmlinux with DWARF for pahole')
+    parser.add_argument('--tool', action='append',
+                        help='only run cases for this tool (repeatable)')
+    parser.add_argument('-o', '--output',
+                        help='write JSON lines here instead of stdout')
+    parser.add_argument('--trace',
+                        default=os.environ.get('BENCHMARK_PREBUILTS_TRACE'),
+                        help='write a Chrome trace JSON of all runs here')
+    args = parser.parse_args()
+
+    if (args.modules_dir and not args.kernel_release and
+            (not args.tool or 'depmod' in args.tool)):
+        releases_dir = os.path.join(args.modules_dir, 'lib', 'modules')
+        releases = (os.listdir(releases_dir)
+                    if os.path.isdir(releases_dir) else [])
+        if len(releases) != 1:
+            parser.error('cannot infer the kernel release from %s; pass '
+                         '--kernel-release' % releases_dir)
+        args.kernel_release = releases[0]
+
+    # Lets peak_rss() reap tools whose launching shell has already exited.
+    libc = ctypes.CDLL(None, use_errno=True)
+    if libc.prctl(PR_SET_CHILD_SUBREAPER, 1, 0, 0, 0) != 0:
+        raise OSError(ctypes.get_errno(), 'prctl(PR_SET_CHILD_SUBREAPER)')
+
+    trace = Trace() if args.trace else None
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    workdir = tempfile.mkdtemp(prefix='benchmark-prebuilts.')
+    try:
+        fixtures = Fixtures(workdir, args.size_mib * MIB)
+        for cmd, returncode in STARTUP_COMMANDS:
+            if args.tool and cmd[0] not in args.tool:
+                continue
+            record = measure_startup(cmd, returncode,
+                                     args.startup_iterations, trace)
+            out.write(json.dumps(record, sort_keys=True) + '\n')
+            out.flush()
+        for (name, case, payload, cmd, inputs,
+             output) in cases(fixtures, args):
+            sys.stderr.write('%s %s\n' % (name, case))
+            record = measure(name, case, payload, cmd, inputs, output,
+                             args.repeat, trace)
+            out.write(json.dumps(record, sort_keys=True) + '\n')
+            out.flush()
+            if output and os.path.exists(output):
+                os.remove(output)
+    finally:
+        shutil.rmtree(workdir)
+        if trace:
+            trace.write(args.trace)
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -76,10 +76,11 @@ EOF
         ${libraries} \
         ${py3_stdlib_zip}
 
-    # Stage binaries
+    # Stage binaries. Preserve timestamps so that unchanged outputs can be
+    # recognized when packaging below.
     mkdir -p ${SOONG_OUT}/dist/bin
-    cp ${binaries} ${SOONG_OUT}/dist/bin/
-    cp -R ${SOONG_HOST_OUT}/lib* ${SOONG_OUT}/dist/
+    cp -p ${binaries} ${SOONG_OUT}/dist/bin/
+    cp -pR ${SOONG_HOST_OUT}/lib* ${SOONG_OUT}/dist/
 
     # Stage include files
     include_dir=${SOONG_OUT}/dist/include
@@ -109,10 +110,12 @@ EOF
       ln -sf libcrypto-host.so lib64/libcrypto.so
     )
 
-    # Package prebuilts
+    # Package prebuilts. On --resume the previous zip is kept and synced
+    # with -FS: entries whose size and timestamp did not change are copied
+    # over already compressed instead of being deflated again.
     (
         cd ${SOONG_OUT}/dist
-        zip -qryX build-prebuilts.zip *
+        zip -qryX -FS build-prebuilts.zip *
     )
 fi
 